@@ -0,0 +1,509 @@
+/*
+ * @Description: Grammar representation shared by LG_Grammar and
+ *               LALR_Generator: interned symbols, productions, and the
+ *               nullable/FIRST/FOLLOW sets with the LL(1) table
+ */
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <iostream>
+#include <fstream>
+#include <cstdint>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+using namespace std;
+
+/**
+ * @description: A set of small integers (symbol or terminal numbers),
+ *               stored one bit per possible member
+ */
+class Bitset {
+public:
+    explicit Bitset(int n = 0) : words((n + 63) / 64, 0) {}
+
+    void set(int i) { words[i >> 6] |= uint64_t(1) << (i & 63); }
+
+    bool test(int i) const { return (words[i >> 6] >> (i & 63)) & 1; }
+
+    // Adds the members of other, returns whether any of them was new
+    bool unionWith(const Bitset& other) {
+        uint64_t changed = 0;
+        for (size_t i = 0; i < words.size(); i++) {
+            uint64_t w = words[i] | other.words[i];
+            changed |= w ^ words[i];
+            words[i] = w;
+        }
+        return changed != 0;
+    }
+
+    // Calls f with every member, in increasing order
+    template <class F>
+    void forEach(F f) const {
+        for (size_t i = 0; i < words.size(); i++) {
+            for (uint64_t w = words[i]; w != 0; w &= w - 1) {
+                f(int(i * 64 + lowestBit(w)));
+            }
+        }
+    }
+
+private:
+    vector<uint64_t> words;
+
+    static int lowestBit(uint64_t w) {
+#if defined(__GNUC__)
+        return __builtin_ctzll(w);
+#else
+        int b = 0;
+        while (!((w >> b) & 1)) {
+            b++;
+        }
+        return b;
+#endif
+    }
+};
+
+// A production left -> right over symbol numbers; right is empty for "."
+struct Production {
+    vector<int> left;
+    vector<int> right;
+};
+
+class Grammar {
+public:
+    // G = (Vn, Vt, P, S); every symbol is interned to a dense number
+    vector<string> names; // name of each symbol
+    vector<int> V;        // the variables, in the order they were declared
+    vector<int> T;        // the terminals, in the order they were declared
+    vector<Production> P;
+    int S = -1;
+    /**
+     * @description: Read grammar through file path
+     * @param {string} filePath
+     * @return {*}
+     * @Author: Tan
+     * @Date: 2023-03-14 10:18:19
+     * @LastEditTime: Do not edit
+     * @LastEditors: Tan
+     */
+    Grammar(string filePath) {
+
+        ifstream fin(filePath);
+        if (!fin) {
+            cout << "Fail to read file!" << endl;
+        } else {
+            string variable, terminal, productions, start;
+            getline(fin, variable);
+            getline(fin, terminal);
+            getline(fin, productions);
+            // Start Symbol
+            getline(fin, start);
+
+            // Read Variables
+            for (string& name : Split(variable, ',')) {
+                if (!name.empty()) {
+                    V.push_back(Declare(name, VARIABLE));
+                }
+            }
+
+            // Read Terminal
+            for (string& name : Split(terminal, ',')) {
+                if (!name.empty()) {
+                    T.push_back(Declare(name, TERMINAL));
+                }
+            }
+
+            // Read Production
+            // Whenever a comma is encountered,
+            // it indicates that a set of production expressions is obtained
+            for (string& production : Split(productions, ',')) {
+                DecomposeProduction(production);
+            }
+
+            start = Trim(start);
+            if (!start.empty()) {
+                S = Intern(start);
+            }
+        }
+    }
+
+    /**
+     * @description: Decomposition production formula
+     * @param {string&} production
+     * @return {*}
+     * @Author: Tan
+     * @Date: 2023-03-14 10:19:59
+     * @LastEditTime: Do not edit
+     * @LastEditors: Tan
+     */
+    void DecomposeProduction(string& production) {
+        size_t pos = production.find("->");
+        if (pos == string::npos) {
+            return;
+        }
+        vector<int> left = DecomposeSymbols(production.substr(0, pos));
+        for (string& right : Split(production.substr(pos + 2), '|')) {
+            P.push_back({left, DecomposeSymbols(right)});
+        }
+    }
+
+    /**
+     * @description: Add the production S' -> S for a new start symbol S'
+     *               and make S' the start symbol
+     * @return {int} the number of the new production
+     */
+    int Augment() {
+        string name = names[S] + "'";
+        while (ids.count(name)) {
+            name += "'";
+        }
+        int x = Declare(name, VARIABLE);
+        V.push_back(x);
+        P.push_back({{x}, {S}});
+        S = x;
+        return (int)P.size() - 1;
+    }
+
+    bool isVariable(int x) const { return kind[x] == VARIABLE; }
+
+    bool isTerminal(int x) const { return kind[x] == TERMINAL; }
+
+    /**
+     * @description: Spell a sequence of symbols; names are separated
+     *               by blanks unless every name is a single character
+     * @param {const vector<int>&} symbols
+     * @return {string}
+     */
+    string Spell(const vector<int>& symbols) const {
+        if (symbols.empty()) {
+            return ".";
+        }
+        string s;
+        for (size_t i = 0; i < symbols.size(); i++) {
+            if (i > 0 && longestName > 1) {
+                s += ' ';
+            }
+            s += names[symbols[i]];
+        }
+        return s;
+    }
+
+private:
+    enum Kind { UNDECLARED, VARIABLE, TERMINAL };
+    vector<Kind> kind;
+    unordered_map<string, int> ids;
+    size_t longestName = 0;
+
+    int Intern(const string& name) {
+        auto it = ids.find(name);
+        if (it != ids.end()) {
+            return it->second;
+        }
+        int x = (int)names.size();
+        ids.emplace(name, x);
+        names.push_back(name);
+        kind.push_back(UNDECLARED);
+        if (name.size() > longestName) {
+            longestName = name.size();
+        }
+        return x;
+    }
+
+    int Declare(const string& name, Kind k) {
+        int x = Intern(name);
+        if (kind[x] == UNDECLARED) {
+            kind[x] = k;
+        }
+        return x;
+    }
+
+    static string Trim(const string& s) {
+        size_t b = s.find_first_not_of(" \t\r\n");
+        if (b == string::npos) {
+            return "";
+        }
+        return s.substr(b, s.find_last_not_of(" \t\r\n") - b + 1);
+    }
+
+    static vector<string> Split(const string& s, char sep) {
+        vector<string> parts;
+        string cur;
+        for (char ch : s) {
+            if (ch == sep) {
+                parts.push_back(Trim(cur));
+                cur = "";
+            } else {
+                cur += ch;
+            }
+        }
+        parts.push_back(Trim(cur));
+        return parts;
+    }
+
+    /**
+     * @description: Split one side of a production into symbols. Names
+     *               separated by blanks are taken as they are; otherwise
+     *               the longest declared name is matched at each position,
+     *               and a character that starts no name is a symbol alone
+     * @param {const string&} side
+     * @return {vector<int>} empty for ".", the empty string
+     */
+    vector<int> DecomposeSymbols(const string& side) {
+        vector<int> symbols;
+        string s = Trim(side);
+        if (s == ".") {
+            return symbols;
+        }
+        if (s.find_first_of(" \t") != string::npos) {
+            size_t i = 0;
+            while ((i = s.find_first_not_of(" \t", i)) != string::npos) {
+                size_t j = s.find_first_of(" \t", i);
+                symbols.push_back(Intern(s.substr(i, j == string::npos ? string::npos : j - i)));
+                i = j;
+            }
+            return symbols;
+        }
+        for (size_t i = 0; i < s.size();) {
+            size_t len = min(max(longestName, (size_t)1), s.size() - i);
+            for (; len > 1; len--) {
+                auto it = ids.find(s.substr(i, len));
+                if (it != ids.end() && kind[it->second] != UNDECLARED) {
+                    break;
+                }
+            }
+            symbols.push_back(Intern(s.substr(i, len)));
+            i += len;
+        }
+        return symbols;
+    }
+};
+
+/**
+ * @description: The nullable, FIRST and FOLLOW sets and the LL(1) parse
+ *               table of a context-free grammar (epsilon productions
+ *               allowed). Sets are bitsets over the terminal columns:
+ *               column c < T.size() is terminal T[c], the last column is
+ *               the end marker $. Symbols that are neither declared nor
+ *               on a left side count as terminals.
+ */
+class LL1 {
+public:
+    struct Conflict {
+        int variable, column, first, second; // two productions for one cell
+    };
+
+    bool contextFree = true;
+    vector<int> column;       // terminal column of each symbol, -1 for variables
+    vector<string> colName;   // name of each column
+    vector<bool> nullable;    // per symbol
+    vector<Bitset> first;     // per symbol
+    vector<Bitset> follow;    // per symbol (variables only)
+    vector<int> row;          // table row of each variable, -1 for terminals
+    vector<int> rowVariable;  // the variable of each row
+    vector<int> table;        // rows * columns production numbers, -1 = error
+    vector<Conflict> conflicts;
+
+    LL1(Grammar& G) : G(G) {
+        int n = (int)G.names.size();
+        for (const Production& p : G.P) {
+            if (p.left.size() != 1) {
+                contextFree = false;
+                return;
+            }
+        }
+        // variables are the declared ones and every left side
+        vector<bool> isVar(n, false);
+        for (int x = 0; x < n; x++) {
+            isVar[x] = G.isVariable(x);
+        }
+        for (const Production& p : G.P) {
+            isVar[p.left[0]] = true;
+        }
+        column.assign(n, -1);
+        row.assign(n, -1);
+        for (int x : G.T) {
+            if (!isVar[x]) {
+                column[x] = (int)colName.size();
+                colName.push_back(G.names[x]);
+            }
+        }
+        for (int x = 0; x < n; x++) {
+            if (isVar[x]) {
+                row[x] = (int)rowVariable.size();
+                rowVariable.push_back(x);
+            } else if (column[x] < 0) {
+                column[x] = (int)colName.size();
+                colName.push_back(G.names[x]);
+            }
+        }
+        colName.push_back("$");
+        ComputeNullable();
+        ComputeFirst();
+        ComputeFollow();
+        BuildTable();
+    }
+
+    int columns() const { return (int)colName.size(); }
+
+    // FIRST of the sentential form w, and whether w is nullable
+    bool FirstOf(const vector<int>& w, Bitset& set) const {
+        for (int x : w) {
+            set.unionWith(first[x]);
+            if (!nullable[x]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    Grammar& G;
+
+    /**
+     * @description: A variable is nullable once some production of it has
+     *               only nullable symbols left; count them down per
+     *               production as symbols become nullable
+     */
+    void ComputeNullable() {
+        int n = (int)G.names.size();
+        vector<int> remaining(G.P.size());
+        vector<vector<int>> occurs(n); // productions using each symbol
+        vector<int> work;
+        nullable.assign(n, false);
+        for (size_t i = 0; i < G.P.size(); i++) {
+            const Production& p = G.P[i];
+            remaining[i] = (int)p.right.size();
+            for (int x : p.right) {
+                occurs[x].push_back((int)i);
+            }
+            if (p.right.empty() && !nullable[p.left[0]]) {
+                nullable[p.left[0]] = true;
+                work.push_back(p.left[0]);
+            }
+        }
+        while (!work.empty()) {
+            int x = work.back();
+            work.pop_back();
+            for (int i : occurs[x]) {
+                int a = G.P[i].left[0];
+                if (--remaining[i] == 0 && !nullable[a]) {
+                    nullable[a] = true;
+                    work.push_back(a);
+                }
+            }
+        }
+    }
+
+    /**
+     * @description: FIRST(A) takes in FIRST(X) for each X of a production
+     *               of A reached through nullable symbols; propagate along
+     *               those edges until nothing changes
+     */
+    void ComputeFirst() {
+        int n = (int)G.names.size();
+        vector<vector<int>> feeds(n); // X -> the variables whose FIRST includes FIRST(X)
+        first.assign(n, Bitset(columns()));
+        for (int x = 0; x < n; x++) {
+            if (row[x] < 0) {
+                first[x].set(column[x]);
+            }
+        }
+        for (const Production& p : G.P) {
+            int a = p.left[0];
+            for (int x : p.right) {
+                if (row[x] < 0) {
+                    first[a].set(column[x]);
+                } else if (x != a) {
+                    feeds[x].push_back(a);
+                }
+                if (!nullable[x]) {
+                    break;
+                }
+            }
+        }
+        Propagate(first, feeds);
+    }
+
+    /**
+     * @description: For A -> wBv, FOLLOW(B) takes in FIRST(v) and, when v
+     *               is nullable, FOLLOW(A)
+     */
+    void ComputeFollow() {
+        int n = (int)G.names.size();
+        vector<vector<int>> feeds(n); // A -> the variables whose FOLLOW includes FOLLOW(A)
+        follow.assign(n, Bitset(columns()));
+        if (G.S >= 0 && row[G.S] >= 0) {
+            follow[G.S].set(columns() - 1);
+        }
+        for (const Production& p : G.P) {
+            int a = p.left[0];
+            Bitset trailer(columns()); // FIRST of the symbols after position i
+            bool trailerNullable = true;
+            for (int i = (int)p.right.size() - 1; i >= 0; i--) {
+                int x = p.right[i];
+                if (row[x] >= 0) {
+                    follow[x].unionWith(trailer);
+                    if (trailerNullable && x != a) {
+                        feeds[a].push_back(x);
+                    }
+                }
+                if (nullable[x]) {
+                    trailer.unionWith(first[x]);
+                } else {
+                    trailer = first[x];
+                    trailerNullable = false;
+                }
+            }
+        }
+        Propagate(follow, feeds);
+    }
+
+    // Worklist fixpoint: sets[y] includes sets[x] for every y in feeds[x]
+    void Propagate(vector<Bitset>& sets, const vector<vector<int>>& feeds) {
+        vector<int> work(rowVariable.rbegin(), rowVariable.rend());
+        vector<bool> queued(sets.size(), false);
+        for (int x : work) {
+            queued[x] = true;
+        }
+        while (!work.empty()) {
+            int x = work.back();
+            work.pop_back();
+            queued[x] = false;
+            for (int y : feeds[x]) {
+                if (sets[y].unionWith(sets[x]) && !queued[y]) {
+                    queued[y] = true;
+                    work.push_back(y);
+                }
+            }
+        }
+    }
+
+    /**
+     * @description: M[A, a] = A -> w for a in FIRST(w), and for a in
+     *               FOLLOW(A) when w is nullable; a second production
+     *               for a cell is a conflict
+     */
+    void BuildTable() {
+        int cols = columns();
+        table.assign(rowVariable.size() * cols, -1);
+        for (size_t i = 0; i < G.P.size(); i++) {
+            const Production& p = G.P[i];
+            int a = p.left[0];
+            Bitset select(cols);
+            if (FirstOf(p.right, select)) {
+                select.unionWith(follow[a]);
+            }
+            select.forEach([&](int c) {
+                int& cell = table[row[a] * cols + c];
+                if (cell < 0) {
+                    cell = (int)i;
+                } else if (cell != (int)i) {
+                    conflicts.push_back({a, c, cell, (int)i});
+                }
+            });
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,496 @@
+/*
+ * @Description: LALR(1) parse table generator. Reads a grammar in the
+ *               LG_Grammar format and writes its action and goto tables,
+ *               compressed by row displacement, as static C arrays
+ */
+#include <iostream>
+#include <fstream>
+#include <map>
+#include <set>
+#include <tuple>
+#include "Grammar.h"
+using namespace std;
+
+/**
+ * @description: The LR(0) automaton of a context-free grammar with LALR(1)
+ *               lookaheads computed by the DeRemer-Pennello relations
+ *               (reads, includes, lookback) over the nonterminal
+ *               transitions. An item is a production with a dot, numbered
+ *               itemBase[p] + dot.
+ */
+class LALR {
+public:
+    struct Conflict {
+        int state, column, kept, dropped; // actions, see Action()
+    };
+
+    vector<vector<int>> kernels;              // kernel items of each state
+    vector<vector<pair<int, int>>> trans;     // (symbol, state), by symbol
+    vector<vector<int>> action;               // state x column, see Action()
+    vector<Conflict> conflicts;
+    int accept;
+
+    // Actions: 0 = error, s > 0 = shift to state s, -(p + 1) = reduce by p
+    static int Shift(int s) { return s; }
+    static int Reduce(int p) { return -(p + 1); }
+
+    LALR(Grammar& G, LL1& A, int accept) : accept(accept), G(G), A(A) {
+        for (const Production& p : G.P) {
+            itemBase.push_back(nitems);
+            nitems += (int)p.right.size() + 1;
+        }
+        for (size_t p = 0; p < G.P.size(); p++) {
+            for (size_t dot = 0; dot <= G.P[p].right.size(); dot++) {
+                itemProd.push_back((int)p);
+                bool nullable = true;
+                for (size_t i = dot; i < G.P[p].right.size(); i++) {
+                    nullable = nullable && A.nullable[G.P[p].right[i]];
+                }
+                suffixNullable.push_back(nullable);
+            }
+        }
+        byLeft.resize(G.names.size());
+        for (size_t p = 0; p < G.P.size(); p++) {
+            byLeft[G.P[p].left[0]].push_back((int)p);
+        }
+        BuildAutomaton();
+        ComputeLookaheads();
+        BuildActions();
+    }
+
+    int Goto(int state, int x) const {
+        const vector<pair<int, int>>& t = trans[state];
+        auto it = lower_bound(t.begin(), t.end(), make_pair(x, -1));
+        return it != t.end() && it->first == x ? it->second : -1;
+    }
+
+private:
+    Grammar& G;
+    LL1& A;
+    int nitems = 0;
+    vector<int> itemBase, itemProd;
+    vector<bool> suffixNullable; // the symbols after the dot are nullable
+    vector<vector<int>> byLeft;  // productions of each variable
+
+    // nonterminal transitions (p, X) and their lookahead sets
+    vector<int> ntFrom, ntVar;
+    map<pair<int, int>, int> ntIndex;
+    vector<Bitset> follow;
+    vector<vector<pair<int, int>>> lookback; // per state: (production, transition)
+    set<tuple<int, int, int>> reported;      // (state, column, dropped action)
+
+    int Dot(int item) const { return item - itemBase[itemProd[item]]; }
+
+    // symbol after the dot, or -1
+    int Next(int item) const {
+        const vector<int>& r = G.P[itemProd[item]].right;
+        int dot = Dot(item);
+        return dot < (int)r.size() ? r[dot] : -1;
+    }
+
+    bool isVar(int x) const { return A.row[x] >= 0; }
+
+    vector<int> Closure(const vector<int>& kernel, vector<int>& stamp, int mark) const {
+        vector<int> items(kernel);
+        for (size_t i = 0; i < items.size(); i++) {
+            int x = Next(items[i]);
+            if (x >= 0 && isVar(x) && stamp[x] != mark) {
+                stamp[x] = mark;
+                for (int p : byLeft[x]) {
+                    items.push_back(itemBase[p]);
+                }
+            }
+        }
+        return items;
+    }
+
+    /**
+     * @description: Build the canonical LR(0) collection, numbering states
+     *               in the order they are found; state 0 holds S' -> .S
+     */
+    void BuildAutomaton() {
+        map<vector<int>, int> index;
+        vector<int> stamp(G.names.size(), -1);
+        kernels.push_back({itemBase[accept]});
+        index[kernels[0]] = 0;
+        for (size_t s = 0; s < kernels.size(); s++) {
+            vector<int> items = Closure(kernels[s], stamp, (int)s);
+            map<int, vector<int>> next; // symbol -> kernel of the successor
+            for (int item : items) {
+                int x = Next(item);
+                if (x >= 0) {
+                    next[x].push_back(item + 1);
+                }
+            }
+            vector<pair<int, int>> t;
+            for (auto& [x, kernel] : next) {
+                sort(kernel.begin(), kernel.end());
+                auto it = index.find(kernel);
+                int target;
+                if (it == index.end()) {
+                    target = (int)kernels.size();
+                    index.emplace(kernel, target);
+                    kernels.push_back(kernel);
+                } else {
+                    target = it->second;
+                }
+                t.push_back({x, target});
+                if (isVar(x)) {
+                    ntIndex[{(int)s, x}] = (int)ntFrom.size();
+                    ntFrom.push_back((int)s);
+                    ntVar.push_back(x);
+                }
+            }
+            trans.push_back(t);
+        }
+    }
+
+    /**
+     * @description: Tarjan's digraph algorithm: F[x] becomes the union of
+     *               F[y] over every y reachable from x through R
+     */
+    static void Digraph(vector<Bitset>& F, const vector<vector<int>>& R) {
+        int n = (int)F.size();
+        vector<int> depth(n, 0), stack;
+        for (int x = 0; x < n; x++) {
+            if (depth[x] == 0) {
+                Traverse(x, F, R, depth, stack);
+            }
+        }
+    }
+
+    static void Traverse(int x, vector<Bitset>& F, const vector<vector<int>>& R,
+                         vector<int>& depth, vector<int>& stack) {
+        stack.push_back(x);
+        int d = (int)stack.size();
+        depth[x] = d;
+        for (int y : R[x]) {
+            if (depth[y] == 0) {
+                Traverse(y, F, R, depth, stack);
+            }
+            depth[x] = min(depth[x], depth[y]);
+            F[x].unionWith(F[y]);
+        }
+        if (depth[x] == d) {
+            int top;
+            do {
+                top = stack.back();
+                stack.pop_back();
+                depth[top] = INT32_MAX;
+                F[top] = F[x];
+            } while (top != x);
+        }
+    }
+
+    /**
+     * @description: Follow(p, A) = Read(p, A) plus Follow of every
+     *               transition it includes, where Read(p, A) is DR(p, A),
+     *               the terminals shifted right after it, plus Read of
+     *               every nullable transition it reads
+     */
+    void ComputeLookaheads() {
+        int n = (int)ntFrom.size(), cols = A.columns();
+        vector<vector<int>> reads(n), includes(n);
+        follow.assign(n, Bitset(cols));
+        lookback.resize(kernels.size());
+        for (int j = 0; j < n; j++) {
+            int r = Goto(ntFrom[j], ntVar[j]);
+            for (auto [x, s] : trans[r]) {
+                if (!isVar(x)) {
+                    follow[j].set(A.column[x]);
+                } else if (A.nullable[x]) {
+                    reads[j].push_back(ntIndex[{r, x}]);
+                }
+            }
+            if (ntFrom[j] == 0 && ntVar[j] == G.P[accept].right[0]) {
+                follow[j].set(cols - 1); // the end marker follows S
+            }
+        }
+        Digraph(follow, reads);
+
+        // walk every production of B from each transition (p, B)
+        for (int j = 0; j < n; j++) {
+            for (int p : byLeft[ntVar[j]]) {
+                const vector<int>& r = G.P[p].right;
+                int s = ntFrom[j];
+                for (size_t i = 0; i < r.size(); i++) {
+                    if (isVar(r[i]) && suffixNullable[itemBase[p] + i + 1]) {
+                        includes[ntIndex[{s, r[i]}]].push_back(j);
+                    }
+                    s = Goto(s, r[i]);
+                }
+                lookback[s].push_back({p, j});
+            }
+        }
+        Digraph(follow, includes);
+    }
+
+    void SetAction(int s, int c, int a) {
+        int& cell = action[s][c];
+        if (cell == 0 || cell == a) {
+            cell = a;
+            return;
+        }
+        // prefer the shift, or the earlier production
+        Conflict k = cell > 0 || (a < 0 && a < cell) ? Conflict{s, c, cell, a} : Conflict{s, c, a, cell};
+        if (reported.insert({s, c, k.dropped}).second) {
+            conflicts.push_back(k);
+        }
+        cell = k.kept;
+    }
+
+    void BuildActions() {
+        int cols = A.columns();
+        action.assign(kernels.size(), vector<int>(cols, 0));
+        for (size_t s = 0; s < kernels.size(); s++) {
+            for (auto [x, t] : trans[s]) {
+                if (!isVar(x)) {
+                    SetAction((int)s, A.column[x], Shift(t));
+                }
+            }
+            for (auto [p, j] : lookback[s]) {
+                follow[j].forEach([&](int c) { SetAction((int)s, c, Reduce(p)); });
+            }
+        }
+        // S' -> S. is reached by no transition on S', accept on the end marker
+        SetAction(Goto(0, G.P[accept].right[0]), cols - 1, Reduce(accept));
+    }
+};
+
+/**
+ * @description: Row displacement: the entries of all rows share one
+ *               vector, row r starting at base[r]; check[i] tells which
+ *               row owns slot i, and missing entries take the row default
+ */
+struct PackedTable {
+    vector<int> base, table, check, defaults;
+
+    // rows[r] holds the (column, value) entries that differ from defaults[r]
+    PackedTable(const vector<vector<pair<int, int>>>& rows, const vector<int>& defaults)
+        : base(rows.size(), 0), defaults(defaults) {
+        Grow(1); // C has no empty arrays
+        vector<int> order(rows.size());
+        for (size_t r = 0; r < rows.size(); r++) {
+            order[r] = (int)r;
+        }
+        stable_sort(order.begin(), order.end(),
+                    [&](int a, int b) { return rows[a].size() > rows[b].size(); });
+        for (int r : order) {
+            if (rows[r].empty()) {
+                continue;
+            }
+            int b = -rows[r][0].first;
+            while (!Fits(rows[r], b)) {
+                b++;
+            }
+            base[r] = b;
+            for (auto [c, v] : rows[r]) {
+                Grow(b + c + 1);
+                table[b + c] = v;
+                check[b + c] = r;
+            }
+        }
+    }
+
+private:
+    void Grow(int n) {
+        if ((int)table.size() < n) {
+            table.resize(n, 0);
+            check.resize(n, -1);
+        }
+    }
+
+    bool Fits(const vector<pair<int, int>>& row, int b) const {
+        for (auto [c, v] : row) {
+            if (b + c < (int)check.size() && check[b + c] >= 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+// Upper case C identifier for a symbol name
+static string Identifier(const string& name) {
+    string s;
+    for (char ch : name) {
+        s += isalnum((unsigned char)ch) ? (char)toupper((unsigned char)ch) : '_';
+    }
+    return s;
+}
+
+static void EmitArray(ofstream& out, const char* name, const vector<int>& v) {
+    bool small = true;
+    for (int x : v) {
+        small = small && x >= -32768 && x <= 32767;
+    }
+    out << "static const " << (small ? "short " : "int ") << name << "[] = {";
+    for (size_t i = 0; i < v.size(); i++) {
+        out << (i % 12 == 0 ? "\n    " : " ") << v[i] << (i + 1 < v.size() ? "," : "");
+    }
+    out << "};\n\n";
+}
+
+/**
+ * @description: Write the tables as a C header for lrparse.c. Terminals
+ *               must be named after the TokenType constants; the end
+ *               marker is ENDFILE
+ */
+static void EmitTables(ofstream& out, const string& grammarPath, Grammar& G, LL1& A, LALR& M) {
+    int cols = A.columns(), nstates = (int)M.kernels.size();
+    int nvars = (int)A.rowVariable.size();
+
+    // action rows: most frequent reduction as the default
+    vector<vector<pair<int, int>>> rows(nstates);
+    vector<int> defaults(nstates, 0);
+    for (int s = 0; s < nstates; s++) {
+        map<int, int> count;
+        for (int a : M.action[s]) {
+            if (a < 0 && a != LALR::Reduce(M.accept)) {
+                count[a]++;
+            }
+        }
+        int best = 0;
+        for (auto [a, n] : count) {
+            if (best == 0 || n > count[best]) {
+                best = a;
+            }
+        }
+        defaults[s] = best;
+        for (int c = 0; c < cols; c++) {
+            if (M.action[s][c] != best && M.action[s][c] != 0) {
+                rows[s].push_back({c, M.action[s][c]});
+            }
+        }
+    }
+    PackedTable action(rows, defaults);
+
+    // goto rows, one per variable, over the states
+    vector<vector<pair<int, int>>> gotoRows(nvars);
+    vector<int> gotoDefaults(nvars, 0);
+    for (int v = 0; v < nvars; v++) {
+        map<int, int> count;
+        int x = A.rowVariable[v], best = 0;
+        for (int s = 0; s < nstates; s++) {
+            int t = M.Goto(s, x);
+            if (t >= 0 && ++count[t] > count[best]) {
+                best = t;
+            }
+        }
+        gotoDefaults[v] = best;
+        for (int s = 0; s < nstates; s++) {
+            int t = M.Goto(s, x);
+            if (t >= 0 && t != best) {
+                gotoRows[v].push_back({s, t});
+            }
+        }
+    }
+    PackedTable gotos(gotoRows, gotoDefaults);
+
+    out << "/****************************************************/\n"
+        << "/* File: lrtab.h                                    */\n"
+        << "/* LALR(1) tables for the TINY parser               */\n"
+        << "/* Generated by LALR_Generator -- do not edit       */\n"
+        << "/****************************************************/\n"
+        << "/* grammar: " << grammarPath << " */\n\n"
+        << "#ifndef _LRTAB_H_\n#define _LRTAB_H_\n\n"
+        << "#define LR_NSTATES " << nstates << "\n"
+        << "#define LR_NTERMS " << cols << "\n"
+        << "#define LR_NVARS " << nvars << "\n"
+        << "#define LR_NPRODS " << G.P.size() << "\n"
+        << "#define LR_TABLESIZE " << action.table.size() << "\n"
+        << "#define LR_GOTOSIZE " << gotos.table.size() << "\n\n";
+
+    // production numbers, named after their left side
+    out << "/* productions */\ntypedef enum\n{\n";
+    map<int, int> alternative;
+    for (size_t p = 0; p < G.P.size(); p++) {
+        const Production& q = G.P[p];
+        string name = (int)p == M.accept
+                          ? string("R_ACCEPT")
+                          : "R_" + Identifier(G.names[q.left[0]]) + "_" + to_string(++alternative[q.left[0]]);
+        out << "  " << name << (p + 1 < G.P.size() ? ", " : "  ")
+            << "/* " << G.Spell(q.left) << " -> " << G.Spell(q.right) << " */\n";
+    }
+    out << "} LrProduction;\n\n";
+
+    out << "/* lrColumn gives the terminal column of a token */\n"
+        << "static int lrColumn(TokenType token)\n{\n  switch (token)\n  {\n";
+    for (int c = 0; c < cols; c++) {
+        out << "  case " << (c == cols - 1 ? string("ENDFILE") : A.colName[c]) << ":\n"
+            << "    return " << c << ";\n";
+    }
+    out << "  default:\n    return -1;\n  }\n}\n\n";
+
+    vector<int> lhs, len;
+    for (const Production& q : G.P) {
+        lhs.push_back(A.row[q.left[0]]);
+        len.push_back((int)q.right.size());
+    }
+    out << "/* left side (goto row) and length of each production */\n";
+    EmitArray(out, "lrProdLhs", lhs);
+    EmitArray(out, "lrProdLen", len);
+
+    out << "/* actions: 0 = error, s > 0 = shift to state s,\n"
+        << " * -(p + 1) = reduce by production p; the entry for\n"
+        << " * (state, column) is lrTable[lrBase[state] + column]\n"
+        << " * if lrCheck there is state, else lrDefact[state]\n */\n";
+    EmitArray(out, "lrDefact", action.defaults);
+    EmitArray(out, "lrBase", action.base);
+    EmitArray(out, "lrTable", action.table);
+    EmitArray(out, "lrCheck", action.check);
+
+    out << "/* gotos: the entry for (variable, state) is\n"
+        << " * lrGotoTable[lrGotoBase[variable] + state] if\n"
+        << " * lrGotoCheck there is variable, else lrDefgoto[variable]\n */\n";
+    EmitArray(out, "lrDefgoto", gotos.defaults);
+    EmitArray(out, "lrGotoBase", gotos.base);
+    EmitArray(out, "lrGotoTable", gotos.table);
+    EmitArray(out, "lrGotoCheck", gotos.check);
+    out << "#endif\n";
+
+    cout << nstates << " states, " << G.P.size() << " productions, " << cols << " terminals" << endl;
+    cout << "action table: " << action.table.size() << " entries packed from "
+         << nstates * cols << endl;
+    cout << "goto table: " << gotos.table.size() << " entries packed from "
+         << nstates * nvars << endl;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        cout << "usage: " << argv[0] << " <grammar> <tables.h>" << endl;
+        return 1;
+    }
+    Grammar G(argv[1]);
+    if (G.S < 0 || G.P.empty()) {
+        cout << "No grammar in " << argv[1] << endl;
+        return 1;
+    }
+    int accept = G.Augment();
+    LL1 A(G);
+    if (!A.contextFree) {
+        cout << "The grammar is not context-free" << endl;
+        return 1;
+    }
+    LALR M(G, A, accept);
+    for (const LALR::Conflict& k : M.conflicts) {
+        cout << "Conflict in state " << k.state << " on " << A.colName[k.column] << ": ";
+        for (int a : {k.kept, k.dropped}) {
+            if (a > 0) {
+                cout << "shift " << a;
+            } else {
+                const Production& q = G.P[-a - 1];
+                cout << "reduce " << G.Spell(q.left) << "->" << G.Spell(q.right);
+            }
+            cout << (a == k.kept ? " (chosen) / " : "\n");
+        }
+    }
+    ofstream out(argv[2]);
+    if (!out) {
+        cout << "Cannot write " << argv[2] << endl;
+        return 1;
+    }
+    EmitTables(out, argv[1], G, A, M);
+    cout << M.conflicts.size() << " conflicts" << endl;
+    return M.conflicts.empty() ? 0 : 2;
+}
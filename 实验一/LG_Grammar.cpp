@@ -6,98 +6,13 @@
  * @LastEditors: Tan
  */
 #include <iostream>
-#include <fstream>
 #include <cstring>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
+#include "Grammar.h"
 using namespace std;
 
-class Grammar {
-public:
-    // G = (Vn, Vt, P, S);
-    unordered_set<char> V;
-    unordered_set<char> T;
-    unordered_map<string, vector<string>> P;
-    char S;
-    /**
-     * @description: Read grammar through file path
-     * @param {string} filePath
-     * @return {*}
-     * @Author: Tan
-     * @Date: 2023-03-14 10:18:19
-     * @LastEditTime: Do not edit
-     * @LastEditors: Tan
-     */    
-    Grammar(string filePath) {
-        
-        ifstream fin(filePath);
-        if (!fin) {
-            cout << "Fail to read file!" << endl;
-        } else {
-            string variable, terminal, productions;
-            getline(fin, variable);
-            getline(fin, terminal);
-            getline(fin, productions);
-            // Start Symbol
-            S = fin.get(); 
-
-            // Read Variables
-            for (int i = 0; i < variable.size(); i += 2) {
-                V.insert(variable[i]);
-            }
-
-            // Read Terminal
-            for (int i = 0; i < terminal.size(); i += 2) {
-                T.insert(terminal[i]);
-            }
-
-            // Read Production
-            string production;
-            for (int i = 0; i < productions.size(); i++) {
-                char ch = productions[i];
-                // Whenever a comma is encountered, 
-                // it indicates that a set of production expressions is obtained
-                if (ch == ',') {
-                    DecomposeProduction(production);
-                    production = "";
-                } else {
-                    production += ch;
-                }
-            }
-            DecomposeProduction(production);
-        }
-    }
-
-    /**
-     * @description: Decomposition production formula
-     * @param {string&} production
-     * @return {*}
-     * @Author: Tan
-     * @Date: 2023-03-14 10:19:59
-     * @LastEditTime: Do not edit
-     * @LastEditors: Tan
-     */
-    void DecomposeProduction(string& production) {
-        int pos = production.find('-');
-        string left = production.substr(0, pos);
-        string right = production.substr(pos + 2);
-        string cur;
-        for (char& ch : right) {
-            if (ch == '|') {
-                P[left].emplace_back(cur);
-                cur = "";
-            } else {
-                cur += ch;
-            }
-        }
-        P[left].emplace_back(cur);
-    }
-};
-
 /**
  * @description: Check whether it is a string or not in the variable collection
- * @param {string&} s
+ * @param {const vector<int>&} s
  * @param {Grammar&} G
  * @return {*}
  * @Author: Tan
@@ -105,8 +20,8 @@ public:
  * @LastEditTime: Do not edit
  * @LastEditors: Tan
  */
-bool isOfVariable(string s, Grammar& G) {
-    return s.size() == 1 && G.V.count(s[0]);
+bool isOfVariable(const vector<int>& s, Grammar& G) {
+    return s.size() == 1 && G.isVariable(s[0]);
 }
 
 /**
@@ -119,11 +34,9 @@ bool isOfVariable(string s, Grammar& G) {
  * @LastEditors: Tan
  */
 bool check_CSG(Grammar& G) {
-    for (auto [l, r] : G.P) {
-        for (string& rr : r) {
-            if (rr.size() < l.size() || rr == ".") {
-                return false;
-            }
+    for (const Production& p : G.P) {
+        if (p.right.size() < p.left.size() || p.right.empty()) {
+            return false;
         }
     }
     return true;
@@ -139,14 +52,46 @@ bool check_CSG(Grammar& G) {
  * @LastEditors: Tan
  */
 bool check_CFG(Grammar& G) {
-    for (auto [l, r] : G.P) {
-        if (isOfVariable(l, G) == false) {
+    for (const Production& p : G.P) {
+        if (isOfVariable(p.left, G) == false) {
+            return false;
+        }
+        if (p.right.size() < p.left.size() || p.right.empty()) {
             return false;
         }
-        for (string& rr : r) {
-            if (rr.size() < l.size() || rr == ".") {
+    }
+    return true;
+}
+
+/**
+ * @description: Check that every production is A -> w or A -> w with
+ *               one variable allowed at position at of w (0 = first,
+ *               -1 = last), all other symbols of w being terminals
+ * @param {Grammar&} G
+ * @param {int} at
+ * @return {*}
+ */
+static bool check_Linear(Grammar& G, int at) {
+    for (const Production& p : G.P) {
+        // Check the left side of the production
+        if (isOfVariable(p.left, G) == false) {
+            return false;
+        }
+        // Check the right side of the production
+        const vector<int>& r = p.right;
+        if (r.size() == 1) {
+            if (!G.isTerminal(r[0])) {
                 return false;
             }
+        } else if (r.empty()) {
+            return false;
+        } else {
+            size_t skip = at == 0 ? 0 : r.size() - 1;
+            for (size_t i = 0; i < r.size(); i++) {
+                if (i != skip && !G.isTerminal(r[i])) {
+                    return false;
+                }
+            }
         }
     }
     return true;
@@ -162,69 +107,19 @@ bool check_CFG(Grammar& G) {
  * @LastEditors: Tan
  */
 bool check_RG(Grammar& G) {
-    /* 
+    /*
     A -> w
-    A -> Bw 
+    A -> Bw
     */
-    bool isLeft = true;
-    for (auto [l, r] : G.P) {
-        // Check the left side of the production
-        if (isOfVariable(l, G) == false) {
-            isLeft = false;
-            break;
-        }
-        // Check the right side of the production
-        for (int i = 0; i < (int)r.size() && isLeft; i++) {
-            string rr = r[i];
-            if (rr.size() == 1) {
-                if (G.V.count(rr[0]) || G.T.count(rr[0]) == 0) {
-                    isLeft = false;
-                    break;
-                }
-            } else {
-                for (int i = 1; i < (int)rr.size(); i++) {
-                    if (G.T.count(rr[i]) == 0) {
-                        isLeft = false;
-                        break;
-                    }
-                }
-            }
-        }
-    }
-    if (isLeft) {
+    if (check_Linear(G, 0)) {
         return true;
     }
 
-    /* 
+    /*
     A -> w
     A -> wB
     */
-    bool isRight = true;
-    for (auto [l, r] : G.P) {
-        //  Check the left side of the production
-        if (isOfVariable(l, G) == false) {
-            isRight = false;
-            break;
-        }
-        //  Check the right side of the production
-        for (int i = 0; i < (int)r.size() && isRight; i++) {
-            string rr = r[i];
-            if (rr.size() == 1) {
-                if (G.V.count(rr[0]) || G.T.count(rr[0]) == 0) {
-                    isRight = false;
-                    break;
-                }
-            } else {
-                for (int i = (int)rr.size() - 2; i >= 0; i--) {
-                    if (G.T.count(rr[i]) == 0) {
-                        isRight = false;
-                        break;
-                    }
-                }
-            }
-        }
-    }
-    return isRight;
+    return check_Linear(G, -1);
 }
 
 /**
@@ -238,29 +133,27 @@ bool check_RG(Grammar& G) {
  */
 void printGrammar(Grammar& G) {
     // V
-    cout << "The variable:" << endl; 
-    for (char c : G.V) {
-        cout << c << ' ';
+    cout << "The variable:" << endl;
+    for (int x : G.V) {
+        cout << G.names[x] << ' ';
     }
     cout << endl;
 
      // T
      cout << "The terminal:" << endl;
-    for (char c : G.T) {
-        cout << c << ' ';
+    for (int x : G.T) {
+        cout << G.names[x] << ' ';
     }
     cout << endl;
 
     // P
     cout << "The production:" << endl;
-    for (auto [l, r] : G.P) {
-        for (string cur : r) {
-            cout << l << "->" << cur << endl;
-        }
+    for (const Production& p : G.P) {
+        cout << G.Spell(p.left) << "->" << G.Spell(p.right) << endl;
     }
 
     // S
-    cout << "The start symbol is " << G.S << endl;
+    cout << "The start symbol is " << (G.S >= 0 ? G.names[G.S] : "") << endl;
 }
 
 /**
@@ -285,7 +178,75 @@ void check_Grammar(Grammar& G) {
     cout << endl;
 }
 
-int main() {
+/**
+ * @description: Print a set of terminal columns
+ * @param {LL1&} A
+ * @param {const Bitset&} set
+ * @return {*}
+ */
+static void printSet(LL1& A, const Bitset& set) {
+    cout << "{ ";
+    set.forEach([&](int c) { cout << A.colName[c] << ' '; });
+    cout << '}';
+}
+
+/**
+ * @description: Print the nullable, FIRST and FOLLOW sets and the LL(1)
+ *               table of the grammar, with any conflicts
+ * @param {Grammar&} G
+ * @return {*}
+ */
+void check_LL1(Grammar& G) {
+    LL1 A(G);
+    if (!A.contextFree) {
+        cout << "The grammar is not context-free, no LL(1) table" << endl << endl;
+        return;
+    }
+    cout << "The nullable variables:" << endl;
+    for (int x : A.rowVariable) {
+        if (A.nullable[x]) {
+            cout << G.names[x] << ' ';
+        }
+    }
+    cout << endl;
+
+    cout << "The FIRST and FOLLOW sets:" << endl;
+    for (int x : A.rowVariable) {
+        cout << "FIRST(" << G.names[x] << ") = ";
+        printSet(A, A.first[x]);
+        cout << "  FOLLOW(" << G.names[x] << ") = ";
+        printSet(A, A.follow[x]);
+        cout << '\n';
+    }
+
+    cout << "The LL(1) table:" << endl;
+    int cols = A.columns();
+    for (size_t r = 0; r < A.rowVariable.size(); r++) {
+        for (int c = 0; c < cols; c++) {
+            int i = A.table[r * cols + c];
+            if (i >= 0) {
+                cout << "M[" << G.names[A.rowVariable[r]] << ", " << A.colName[c] << "] = "
+                     << G.Spell(G.P[i].left) << "->" << G.Spell(G.P[i].right) << '\n';
+            }
+        }
+    }
+
+    for (const LL1::Conflict& k : A.conflicts) {
+        const Production& p = G.P[k.first];
+        const Production& q = G.P[k.second];
+        cout << "Conflict at M[" << G.names[k.variable] << ", " << A.colName[k.column] << "]: "
+             << G.Spell(p.left) << "->" << G.Spell(p.right) << " / "
+             << G.Spell(q.left) << "->" << G.Spell(q.right) << '\n';
+    }
+    if (A.conflicts.empty()) {
+        cout << "The current grammar is LL(1)" << endl;
+    } else {
+        cout << "The current grammar is not LL(1): " << A.conflicts.size() << " conflicts" << endl;
+    }
+    cout << endl;
+}
+
+int main(int argc, char* argv[]) {
     /* const string filePath = "./Grammar.txt";
     const string RG_filePath = "./RG.txt";
     const string CFG_filePath = "./CFG.txt";
@@ -295,14 +256,22 @@ int main() {
     printGrammar(G);
     check_Grammar(G); */
 
-    // "./Grammar.txt", "./RG.txt", "./CFG.txt", "./CSG.txt", "./PSG.txt"
-    vector<string> paths({"./Grammar.txt", "./RG.txt", "./CFG.txt", "./CSG.txt", "./PSG.txt"});
+    // "./Grammar.txt", "./RG.txt", "./CFG.txt", "./CSG.txt", "./PSG.txt", "./TINY.txt"
+    // unless grammar files are named on the command line
+    vector<string> paths({"./Grammar.txt", "./RG.txt", "./CFG.txt", "./CSG.txt", "./PSG.txt", "./TINY.txt"});
+    if (argc > 1) {
+        paths.assign(argv + 1, argv + argc);
+    }
+    ios::sync_with_stdio(false);
     for (string& path : paths) {
         Grammar G(path);
         printGrammar(G); // print grammar
         check_Grammar(G); // Determine the type of grammar
+        check_LL1(G); // FIRST, FOLLOW and the LL(1) table
         cout << "---------------------------------------" << endl << endl;
     }
-    system("pause");
+    if (argc <= 1) {
+        system("pause");
+    }
     return 0;
-}
\ No newline at end of file
+}